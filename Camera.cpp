@@ -12,7 +12,7 @@ void Camera::UpdateMatrix(float FOVdeg, float nearPlane, float farPlane) {
 	view = glm::lookAt(pos, pos + orientation, up);
 	// Adds perspective to the scene
 	// glm::perspective(field of view, aspect ratio, closest clip plane, furthest clip plane)
-	proj = glm::perspective(glm::radians(FOVdeg), (float)(width / height), nearPlane, farPlane);
+	proj = glm::perspective(glm::radians(FOVdeg), (float)width / height, nearPlane, farPlane);
 
 	// Assigns the camera matrix
 	cameraMatrix = proj * view;
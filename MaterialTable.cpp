@@ -0,0 +1,68 @@
+#include "MaterialTable.h"
+
+#include <algorithm>
+
+// Constructor that generates a UBO big enough for MAX_MATERIALS.
+MaterialTable::MaterialTable(GLuint binding) : binding(binding) {
+	glGenBuffers(1, &ID);
+	glBindBuffer(GL_UNIFORM_BUFFER, ID);
+	// Allocates the whole table once so adding materials never reallocates the buffer
+	glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(Material), NULL, GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+GLuint MaterialTable::AddMaterial(GLint diffuseLayer, GLint specularLayer, float specularStrength, float shininess) {
+	Material material{ glm::ivec4(diffuseLayer, specularLayer, 0, 0), 
+					   glm::vec4(specularStrength, shininess, 0.0f, 0.0f) };
+
+	// Reuses the ID of a removed material before growing the table
+	if (!freeMaterials.empty()) {
+		GLuint materialID = freeMaterials.back();
+		freeMaterials.pop_back();
+		materials[materialID] = material;
+		return materialID;
+	}
+	if (materials.size() >= MAX_MATERIALS) {
+		std::cout << "MATERIAL_TABLE_FULL" << std::endl;
+		return INVALID_MATERIAL;
+	}
+	materials.push_back(material);
+	return (GLuint)(materials.size() - 1);
+}
+
+void MaterialTable::RemoveMaterial(GLuint materialID) {
+	// Freeing an ID twice would hand it out to two materials at once
+	if (materialID >= materials.size() ||
+		std::find(freeMaterials.begin(), freeMaterials.end(), materialID) != freeMaterials.end()) {
+		std::cout << "MATERIAL_NOT_IN_USE: " << materialID << std::endl;
+		return;
+	}
+	freeMaterials.push_back(materialID);
+}
+
+GLuint MaterialTable::NumFreeMaterials() {
+	return MAX_MATERIALS - (GLuint)materials.size() + (GLuint)freeMaterials.size();
+}
+
+void MaterialTable::Upload() {
+	glBindBuffer(GL_UNIFORM_BUFFER, ID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, materials.size() * sizeof(Material), materials.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void MaterialTable::BlockBinding(Shader& shader, const char* block) {
+	GLuint blockIndex = glGetUniformBlockIndex(shader.ID, block);
+	glUniformBlockBinding(shader.ID, blockIndex, binding);
+}
+
+void MaterialTable::Bind() {
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+}
+
+void MaterialTable::Unbind() {
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, 0);
+}
+
+void MaterialTable::Delete() {
+	glDeleteBuffers(1, &ID);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "ShaderClass.h"
+
+// Has to match MAX_MATERIALS in default.frag. 256 materials * 32 bytes stays well under the 16KB 
+// every openGL 3.3 driver guarantees for a uniform block.
+#define MAX_MATERIALS 256
+// Returned by AddMaterial when the table is full
+#define INVALID_MATERIAL 0xFFFFFFFFu
+
+// One entry of the material table. Laid out as two vec4s so it matches std140 without padding.
+struct Material {
+	// x = diffuse layer, y = specular layer in the texture array
+	glm::ivec4 layers;
+	// x = specular strength, y = shininess
+	glm::vec4 params;
+};
+
+// UBO (Uniform Buffer Object) that maps material IDs to texture array layers and lighting 
+// parameters, so one bind covers every material in the scene.
+class MaterialTable {
+public:
+	// Reference ID of the UBO.
+	GLuint ID;
+	// Uniform buffer binding point the table is attached to
+	GLuint binding;
+	// CPU copy of the table, the index is the material ID
+	std::vector<Material> materials;
+	// IDs of removed materials that can be handed out again
+	std::vector<GLuint> freeMaterials;
+
+	// Constructor that generates a UBO big enough for MAX_MATERIALS.
+	MaterialTable(GLuint binding);
+
+	// Adds a material and returns its ID, or INVALID_MATERIAL if the table is full (call Upload() 
+	// afterwards)
+	GLuint AddMaterial(GLint diffuseLayer, GLint specularLayer, float specularStrength, float shininess);
+	// Frees a material's ID so a later AddMaterial can reuse it
+	void RemoveMaterial(GLuint materialID);
+	// Number of materials that can still be added
+	GLuint NumFreeMaterials();
+	// Copies the CPU table into the UBO
+	void Upload();
+	// Points the shader's uniform block at this table's binding point
+	void BlockBinding(Shader& shader, const char* block);
+
+	void Bind();
+	void Unbind();
+	void Delete();
+};
@@ -2,12 +2,24 @@
 
 Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<Texture>& textures) 
 	: vertices(vertices), indices(indices), textures(textures) {
+	// Splits the mesh into meshlets, which reorders the mesh's copy of the indices
+	meshlets = BuildMeshlets(this->vertices, this->indices);
+	Setup();
+}
+
+Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<Meshlet>& meshlets,
+		   std::vector<Texture>& textures) 
+	: vertices(vertices), indices(indices), textures(textures), meshlets(meshlets) {
+	Setup();
+}
+
+void Mesh::Setup() {
 	// Binds vertex array object
 	vao.Bind();
 
 	// Generates Vertex Buffer Object and links it to the vertices.
 	VBO vbo(vertices);
-	// Generates Element Buffer Object and links it to the indices.
+	// Generates Element Buffer Object and links it to the (reordered) indices.
 	EBO ebo(indices);
 
 	// Links VBO to VAO
@@ -19,17 +31,31 @@ Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vec
 	vao.LinkAttrib(vbo, 2, 3, GL_FLOAT, sizeof(Vertex), (void*)(6 * sizeof(float)));
 	// Specifies location of texture coordinates in vertices
 	vao.LinkAttrib(vbo, 3, 2, GL_FLOAT, sizeof(Vertex), (void*)(9 * sizeof(float)));
+	// Specifies location of material IDs in vertices
+	vao.LinkAttrib(vbo, 4, 1, GL_FLOAT, sizeof(Vertex), (void*)(11 * sizeof(float)));
 
 	// Unbind all to prevent modifying these objects later on.
 	vao.Unbind();
 	vbo.Unbind();
 	ebo.Unbind();
+
+	vboID = vbo.ID;
+	eboID = ebo.ID;
 }
 
-void Mesh::Draw(Shader& shader, Camera& camera) {
+void Mesh::Draw(Shader& shader, Camera& camera, const glm::mat4& model) {
+	// Nothing to draw if every meshlet was culled
+	CullMeshlets(meshlets, model, camera.cameraMatrix, camera.pos, drawList);
+	if (drawList.numVisible == 0) {
+		return;
+	}
+
 	shader.Activate();
 	vao.Bind();
 
+	// Binds the mesh's own textures to diffuse0, specular0 and so on, which textured.frag samples.
+	// Meshes using the texture array pass no textures and skip this entirely, default.frag reads the
+	// array and the material table, which are bound once for the whole frame instead.
 	unsigned int numDiffuse = 0;
 	unsigned int numSpecular = 0;
 
@@ -48,5 +74,12 @@ void Mesh::Draw(Shader& shader, Camera& camera) {
 	glUniform3f(glGetUniformLocation(shader.ID, "camPos"), camera.pos.x, camera.pos.y, camera.pos.z);
 	camera.Matrix(shader, "camMatrix");
 
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+	// Draws all the visible index ranges in one call (adjacent meshlets were merged into one range)
+	glMultiDrawElements(GL_TRIANGLES, drawList.counts.data(), GL_UNSIGNED_INT, drawList.offsets.data(), (GLsizei)drawList.counts.size());
+}
+
+void Mesh::Delete() {
+	vao.Delete();
+	glDeleteBuffers(1, &vboID);
+	glDeleteBuffers(1, &eboID);
 }
@@ -6,6 +6,7 @@
 #include "Objects/EBO.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "Meshlet.h"
 #include <vector>
 
 class Mesh {
@@ -14,12 +15,29 @@ public:
 	std::vector<Vertex> vertices;
 	std::vector<GLuint> indices;
 	std::vector<Texture> textures;
+	// Clusters of the mesh's triangles, culled on their own every draw
+	std::vector<Meshlet> meshlets;
+	// Index ranges of the meshlets that survived the last draw's culling
+	MeshletDrawList drawList;
 
 	VAO vao;
+	// Reference IDs of the mesh's VBO and EBO, kept so Delete() can free them
+	GLuint vboID, eboID;
 
 	// Constructs the mesh and links attributes
 	Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<Texture>& textures);
+	// Constructs the mesh from meshlets that were already built (for example on a loader thread).
+	// The indices have to be the ones BuildMeshlets() reordered.
+	Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<Meshlet>& meshlets,
+		 std::vector<Texture>& textures);
 
-	// Draws the mesh
-	void Draw(Shader& shader, Camera& camera);
+	// Draws the meshlets that face the camera and are inside its frustum. model has to match 
+	// the model matrix the shader transforms the mesh with.
+	void Draw(Shader& shader, Camera& camera, const glm::mat4& model = glm::mat4(1.0f));
+	// Deletes the mesh's VAO, VBO and EBO
+	void Delete();
+
+private:
+	// Generates the VBO and EBO and links attributes
+	void Setup();
 };
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Fills in the bounding sphere and normal cone of a meshlet from its triangles
+static void ComputeBounds(Meshlet& meshlet, const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices) {
+	// Bounding sphere centered on the bounding box
+	glm::vec3 minPos = vertices[indices[meshlet.indexOffset]].position;
+	glm::vec3 maxPos = minPos;
+	for (GLuint i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; ++i) {
+		minPos = glm::min(minPos, vertices[indices[i]].position);
+		maxPos = glm::max(maxPos, vertices[indices[i]].position);
+	}
+	meshlet.center = (minPos + maxPos) * 0.5f;
+	meshlet.radius = 0.0f;
+	for (GLuint i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; ++i) {
+		meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, vertices[indices[i]].position));
+	}
+
+	// Normals come from the winding (counter-clockwise is front facing) since that is what
+	// decides whether a triangle is back facing
+	std::vector<glm::vec3> normals;
+	glm::vec3 axis = glm::vec3(0.0f);
+	for (GLuint i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i += 3) {
+		glm::vec3 a = vertices[indices[i]].position;
+		glm::vec3 b = vertices[indices[i + 1]].position;
+		glm::vec3 c = vertices[indices[i + 2]].position;
+		glm::vec3 normal = glm::cross(b - a, c - a);
+		float length = glm::length(normal);
+		// Degenerate triangles don't face any direction
+		if (length == 0.0f) {
+			continue;
+		}
+		normals.push_back(normal / length);
+		axis += normals.back();
+	}
+
+	// No cone if the normals cancel out or some triangle faces more than 90 degrees off the axis
+	meshlet.coneAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+	meshlet.coneCutoff = 1.0f;
+	if (normals.empty() || glm::length(axis) == 0.0f) {
+		return;
+	}
+	axis = glm::normalize(axis);
+	float minDot = 1.0f;
+	for (glm::vec3& normal : normals) {
+		minDot = std::min(minDot, glm::dot(axis, normal));
+	}
+	if (minDot <= 0.0f) {
+		return;
+	}
+	meshlet.coneAxis = axis;
+	meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
+	std::vector<Meshlet> meshlets;
+	size_t numTriangles = indices.size() / 3;
+
+	// Triangles using each vertex, so meshlets can grow into neighboring triangles
+	std::vector<std::vector<GLuint>> vertexTriangles(vertices.size());
+	for (GLuint t = 0; t < numTriangles; ++t) {
+		for (size_t j = 0; j < 3; ++j) {
+			vertexTriangles[indices[t * 3 + j]].push_back(t);
+		}
+	}
+
+	std::vector<bool> used(numTriangles, false);
+	// The meshlet each vertex was last added to, so checking if a vertex is new is O(1)
+	std::vector<int> vertexMeshlet(vertices.size(), -1);
+	std::vector<GLuint> reordered;
+	reordered.reserve(numTriangles * 3);
+	// Triangles sharing a vertex with the current meshlet
+	std::vector<GLuint> candidates;
+	size_t nextSeed = 0;
+
+	// Number of vertices of a triangle that the current meshlet doesn't have yet
+	auto newVertices = [&](GLuint t) {
+		GLuint a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+		int current = (int)meshlets.size();
+		return (GLuint)((vertexMeshlet[a] != current) + (vertexMeshlet[b] != current && b != a) +
+						(vertexMeshlet[c] != current && c != a && c != b));
+	};
+
+	Meshlet meshlet = Meshlet();
+	while (reordered.size() < numTriangles * 3) {
+		// Picks the neighboring triangle that adds the fewest vertices, which keeps meshlets
+		// compact (tighter bounds and cones cull better)
+		GLuint best = 0;
+		GLuint bestNew = 4;
+		size_t numKept = 0;
+		for (GLuint t : candidates) {
+			// Drops triangles that were taken since they were added, so the list stays short
+			if (used[t]) {
+				continue;
+			}
+			candidates[numKept++] = t;
+			GLuint numNew = newVertices(t);
+			if (numNew < bestNew) {
+				best = t;
+				bestNew = numNew;
+			}
+		}
+		candidates.resize(numKept);
+		// No neighbors left, continues with the next unused triangle in the index buffer
+		if (bestNew == 4) {
+			while (used[nextSeed]) {
+				++nextSeed;
+			}
+			best = (GLuint)nextSeed;
+			bestNew = newVertices(best);
+		}
+
+		// Starts a new meshlet once the triangle doesn't fit anymore
+		if (meshlet.vertexCount + bestNew > MESHLET_MAX_VERTICES || meshlet.indexCount / 3 + 1 > MESHLET_MAX_TRIANGLES) {
+			meshlets.push_back(meshlet);
+			meshlet = Meshlet();
+			meshlet.indexOffset = (GLuint)reordered.size();
+			candidates.clear();
+			continue;
+		}
+
+		used[best] = true;
+		meshlet.vertexCount += bestNew;
+		meshlet.indexCount += 3;
+		for (size_t j = 0; j < 3; ++j) {
+			GLuint index = indices[best * 3 + j];
+			reordered.push_back(index);
+			if (vertexMeshlet[index] != (int)meshlets.size()) {
+				vertexMeshlet[index] = (int)meshlets.size();
+				candidates.insert(candidates.end(), vertexTriangles[index].begin(), vertexTriangles[index].end());
+			}
+		}
+	}
+	if (meshlet.indexCount > 0) {
+		meshlets.push_back(meshlet);
+	}
+
+	// Leftover indices that don't make a whole triangle are dropped, they were never drawn
+	indices = reordered;
+	for (Meshlet& m : meshlets) {
+		ComputeBounds(m, vertices, indices);
+	}
+	return meshlets;
+}
+
+MeshletStats ComputeMeshletStats(const std::vector<Meshlet>& meshlets) {
+	MeshletStats stats;
+	stats.numMeshlets = meshlets.size();
+	if (meshlets.empty()) {
+		return stats;
+	}
+	for (const Meshlet& meshlet : meshlets) {
+		stats.vertexFill += (float)meshlet.vertexCount / MESHLET_MAX_VERTICES;
+		stats.triangleFill += (float)(meshlet.indexCount / 3) / MESHLET_MAX_TRIANGLES;
+	}
+	stats.vertexFill /= meshlets.size();
+	stats.triangleFill /= meshlets.size();
+	return stats;
+}
+
+void CullMeshlets(const std::vector<Meshlet>& meshlets, const glm::mat4& model, const glm::mat4& camMatrix,
+				  glm::vec3 camPos, MeshletDrawList& drawList) {
+	drawList.counts.clear();
+	drawList.offsets.clear();
+	drawList.numVisible = 0;
+	drawList.numBackfacing = 0;
+	drawList.numOutsideFrustum = 0;
+
+	// Frustum planes in world space, taken from the rows of the camera matrix (Gribb/Hartmann)
+	glm::mat4 m = glm::transpose(camMatrix);
+	glm::vec4 planes[6] = { m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2] };
+	for (glm::vec4& plane : planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	// Bounds are stored in model space, so they are moved into world space here. The radius
+	// grows with the largest scale of the model matrix.
+	glm::mat3 rotation = glm::mat3(model);
+	float maxScale = std::max(glm::length(rotation[0]), std::max(glm::length(rotation[1]), glm::length(rotation[2])));
+
+	// Normal cones only stay cones of the same angle under rotation and uniform scale. Any other
+	// model (non-uniform scale, shear or mirroring) skips back-face culling. The columns of such a
+	// matrix are orthogonal and equally long, and its determinant is positive.
+	glm::mat3 gram = glm::transpose(rotation) * rotation;
+	float scaleSq = gram[0][0];
+	bool keepsCones = glm::determinant(rotation) > 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			keepsCones &= std::abs(gram[i][j] - (i == j ? scaleSq : 0.0f)) <= 1e-4f * scaleSq;
+		}
+	}
+
+	for (const Meshlet& meshlet : meshlets) {
+		glm::vec3 center = glm::vec3(model * glm::vec4(meshlet.center, 1.0f));
+		float radius = meshlet.radius * maxScale;
+
+		// BACKFACE CULLING
+		// Every triangle faces away from the camera if the camera is outside the cone of normals,
+		// pushed back by the radius so it holds for any point in the meshlet
+		if (keepsCones && meshlet.coneCutoff < 1.0f) {
+			glm::vec3 axis = glm::normalize(rotation * meshlet.coneAxis);
+			glm::vec3 toCenter = center - camPos;
+			if (glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + radius) {
+				++drawList.numBackfacing;
+				continue;
+			}
+		}
+
+		// FRUSTUM CULLING
+		bool outside = false;
+		for (glm::vec4& plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+				outside = true;
+				break;
+			}
+		}
+		if (outside) {
+			++drawList.numOutsideFrustum;
+			continue;
+		}
+
+		++drawList.numVisible;
+		// Extends the previous range if this meshlet starts right where it ends
+		const void* offset = (const void*)(meshlet.indexOffset * sizeof(GLuint));
+		if (!drawList.counts.empty() &&
+			(const char*)drawList.offsets.back() + drawList.counts.back() * sizeof(GLuint) == offset) {
+			drawList.counts.back() += meshlet.indexCount;
+		}
+		else {
+			drawList.counts.push_back(meshlet.indexCount);
+			drawList.offsets.push_back(offset);
+		}
+	}
+}
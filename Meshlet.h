@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Objects/VBO.h"
+
+// Limits of a single meshlet. 64 vertices and 124 triangles is the size mesh shading hardware is
+// built around, and small enough that culling throws away little visible geometry.
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+// A cluster of neighboring triangles that is culled as a whole.
+struct Meshlet {
+	// Range of the meshlet's indices in the (reordered) index buffer
+	GLuint indexOffset;
+	GLuint indexCount;
+	// Number of unique vertices the meshlet uses
+	GLuint vertexCount;
+
+	// Bounding sphere
+	glm::vec3 center;
+	float radius;
+
+	// Normal cone. Every triangle's normal is within the cone around coneAxis. coneCutoff is the
+	// sine of the cone's half angle, or 1 if the triangles face too many ways to ever be culled.
+	glm::vec3 coneAxis;
+	float coneCutoff;
+};
+
+// How well the builder filled the meshlets
+struct MeshletStats {
+	size_t numMeshlets = 0;
+	// Average fraction of MESHLET_MAX_VERTICES and MESHLET_MAX_TRIANGLES used
+	float vertexFill = 0.0f;
+	float triangleFill = 0.0f;
+};
+
+// The index ranges that survived culling, ready for glMultiDrawElements
+struct MeshletDrawList {
+	std::vector<GLsizei> counts;
+	std::vector<const void*> offsets;
+
+	// What happened to the meshlets the last time they were culled
+	size_t numVisible = 0;
+	size_t numBackfacing = 0;
+	size_t numOutsideFrustum = 0;
+};
+
+// Splits the triangles into meshlets. The indices are reordered so every meshlet's triangles
+// are next to each other.
+std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+MeshletStats ComputeMeshletStats(const std::vector<Meshlet>& meshlets);
+
+// Rejects meshlets that are facing away from the camera or outside its frustum and fills in
+// the index ranges of the rest. Adjacent visible meshlets are merged into one range. Back-face
+// culling is skipped unless model only rotates, uniformly scales and translates.
+void CullMeshlets(const std::vector<Meshlet>& meshlets, const glm::mat4& model, const glm::mat4& camMatrix,
+				  glm::vec3 camPos, MeshletDrawList& drawList);
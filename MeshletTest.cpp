@@ -0,0 +1,167 @@
+/*
+* Headless checks of the meshlet builder and culling. Only needs glm, no window or openGL
+* context, so it runs anywhere. Returns 0 if every check passes.
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Meshlet.h"
+
+static int numFailed = 0;
+
+static void Check(bool passed, const char* what) {
+	if (!passed) {
+		std::cout << "FAILED: " << what << std::endl;
+		++numFailed;
+	}
+}
+
+// UV sphere of radius 1 around the origin, wound counter-clockwise seen from outside
+static void BuildSphere(int rings, int segments, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
+	for (int r = 0; r <= rings; ++r) {
+		for (int s = 0; s <= segments; ++s) {
+			float theta = glm::pi<float>() * r / rings;
+			float phi = 2.0f * glm::pi<float>() * s / segments;
+			glm::vec3 position = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			Vertex vertex = Vertex();
+			vertex.position = position;
+			vertex.normal = position;
+			vertices.push_back(vertex);
+		}
+	}
+	for (int r = 0; r < rings; ++r) {
+		for (int s = 0; s < segments; ++s) {
+			GLuint a = r * (segments + 1) + s;
+			GLuint b = a + segments + 1;
+			indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+		}
+	}
+}
+
+// Triangles rotated so the smallest index comes first (keeps the winding) and sorted, so two
+// index buffers can be compared regardless of triangle order
+static std::vector<std::array<GLuint, 3>> SortedTriangles(const std::vector<GLuint>& indices) {
+	std::vector<std::array<GLuint, 3>> triangles;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		std::array<GLuint, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+		std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+		triangles.push_back(t);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// Culls the meshlets for a camera and checks, triangle by triangle, that nothing that should be
+// drawn was culled. Returns the fraction of meshlets that were culled.
+static float CheckCulling(const char* name, const std::vector<Meshlet>& meshlets, const std::vector<Vertex>& vertices,
+						  const std::vector<GLuint>& indices, const glm::mat4& model, glm::vec3 camPos, glm::vec3 target) {
+	glm::mat4 camMatrix = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+						  glm::lookAt(camPos, target, glm::vec3(0.0f, 1.0f, 0.0f));
+	MeshletDrawList drawList;
+	CullMeshlets(meshlets, model, camMatrix, camPos, drawList);
+	Check(drawList.numVisible + drawList.numBackfacing + drawList.numOutsideFrustum == meshlets.size(),
+		  "every meshlet is either visible or culled");
+
+	std::vector<bool> drawn(indices.size() / 3, false);
+	for (size_t i = 0; i < drawList.counts.size(); ++i) {
+		size_t first = (size_t)drawList.offsets[i] / sizeof(GLuint);
+		for (size_t j = first; j < first + drawList.counts[i]; j += 3) {
+			drawn[j / 3] = true;
+		}
+	}
+
+	// Front facing triangles with a corner inside the frustum have to be drawn
+	size_t numWronglyCulled = 0;
+	for (size_t t = 0; t < drawn.size(); ++t) {
+		glm::vec3 corners[3];
+		bool inside = false;
+		for (size_t j = 0; j < 3; ++j) {
+			corners[j] = glm::vec3(model * glm::vec4(vertices[indices[t * 3 + j]].position, 1.0f));
+			glm::vec4 clip = camMatrix * glm::vec4(corners[j], 1.0f);
+			inside |= std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && std::abs(clip.z) <= clip.w;
+		}
+		bool frontFacing = glm::dot(glm::cross(corners[1] - corners[0], corners[2] - corners[0]), camPos - corners[0]) > 0.0f;
+		if (!drawn[t] && frontFacing && inside) {
+			++numWronglyCulled;
+		}
+	}
+	Check(numWronglyCulled == 0, "no visible front facing triangle is culled");
+
+	std::cout << name << ": " << drawList.numVisible << " visible, " << drawList.numBackfacing << " back facing, "
+			  << drawList.numOutsideFrustum << " outside the frustum, " << drawList.counts.size() << " draw ranges, "
+			  << numWronglyCulled << " wrongly culled triangles" << std::endl;
+	return (float)(drawList.numBackfacing + drawList.numOutsideFrustum) / meshlets.size();
+}
+
+int main() {
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	BuildSphere(128, 256, vertices, indices);
+	std::vector<GLuint> original = indices;
+
+	std::vector<Meshlet> meshlets = BuildMeshlets(vertices, indices);
+	MeshletStats stats = ComputeMeshletStats(meshlets);
+	std::cout << "Sphere: " << original.size() / 3 << " triangles, " << stats.numMeshlets << " meshlets, vertex fill "
+			  << stats.vertexFill << ", triangle fill " << stats.triangleFill << std::endl;
+
+	// BUILDER
+	Check(SortedTriangles(indices) == SortedTriangles(original), "reordering keeps every triangle and its winding");
+	GLuint nextOffset = 0;
+	for (const Meshlet& meshlet : meshlets) {
+		Check(meshlet.indexOffset == nextOffset, "meshlets cover the index buffer in order");
+		nextOffset = meshlet.indexOffset + meshlet.indexCount;
+		Check(meshlet.indexCount > 0 && meshlet.indexCount % 3 == 0, "meshlets hold whole triangles");
+		Check(meshlet.indexCount / 3 <= MESHLET_MAX_TRIANGLES, "meshlets stay under the triangle limit");
+
+		std::vector<GLuint> unique(indices.begin() + meshlet.indexOffset, indices.begin() + nextOffset);
+		std::sort(unique.begin(), unique.end());
+		unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+		Check(unique.size() == meshlet.vertexCount, "vertexCount matches the meshlet's unique vertices");
+		Check(meshlet.vertexCount <= MESHLET_MAX_VERTICES, "meshlets stay under the vertex limit");
+
+		// Bounds have to hold every vertex and every triangle's normal
+		for (GLuint i = meshlet.indexOffset; i < nextOffset; i += 3) {
+			glm::vec3 a = vertices[indices[i]].position;
+			glm::vec3 b = vertices[indices[i + 1]].position;
+			glm::vec3 c = vertices[indices[i + 2]].position;
+			Check(glm::distance(a, meshlet.center) <= meshlet.radius * 1.0001f, "bounding sphere holds the vertices");
+			glm::vec3 normal = glm::cross(b - a, c - a);
+			if (meshlet.coneCutoff < 1.0f && glm::length(normal) > 0.0f) {
+				float minDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+				Check(glm::dot(glm::normalize(normal), meshlet.coneAxis) >= minDot - 0.0001f, "normal cone holds the normals");
+			}
+		}
+	}
+	Check(nextOffset == indices.size(), "meshlets cover every index");
+	// What the builder reached when it was written, so regressions show up
+	Check(stats.vertexFill >= 0.9f && stats.triangleFill >= 0.7f, "meshlets are well filled");
+
+	// CULLING
+	// Only the near side of the sphere faces the camera, so a good share of meshlets is culled
+	float culled = CheckCulling("Front", meshlets, vertices, indices, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f));
+	Check(culled >= 0.4f, "back facing meshlets are culled");
+	CheckCulling("Close up", meshlets, vertices, indices, glm::mat4(1.0f), glm::vec3(0.3f, 0.0f, 1.2f), glm::vec3(0.3f, 0.0f, 0.0f));
+	// Bounds are transformed by the model matrix
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, 0.5f, -1.0f));
+	model = glm::rotate(model, glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	model = glm::scale(model, glm::vec3(2.0f));
+	CheckCulling("Moved", meshlets, vertices, indices, model, glm::vec3(0.0f, 1.0f, 6.0f), glm::vec3(2.0f, 0.5f, -1.0f));
+	// Non-uniform scale bends the normals, so the cones no longer hold them
+	glm::mat4 stretched = glm::scale(model, glm::vec3(0.3f, 1.0f, 3.0f));
+	CheckCulling("Stretched", meshlets, vertices, indices, stretched, glm::vec3(0.0f, 1.0f, 8.0f), glm::vec3(2.0f, 0.5f, -1.0f));
+	// Mirroring flips which side of a triangle faces out
+	glm::mat4 mirrored = glm::scale(model, glm::vec3(-1.0f, 1.0f, 1.0f));
+	CheckCulling("Mirrored", meshlets, vertices, indices, mirrored, glm::vec3(0.0f, 1.0f, 6.0f), glm::vec3(2.0f, 0.5f, -1.0f));
+	// Looking away from the sphere culls all of it
+	culled = CheckCulling("Away", meshlets, vertices, indices, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, 6.0f));
+	Check(culled == 1.0f, "meshlets behind the camera are culled");
+
+	std::cout << (numFailed == 0 ? "All meshlet checks passed" : "Some meshlet checks failed") << std::endl;
+	return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include "FBO.h"
+
+#include <iostream>
+
+// Constructor that generates a FBO with attachments of the given size.
+FBO::FBO(GLsizei width, GLsizei height) : width(width), height(height) {
+	glGenFramebuffers(1, &ID);
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+
+	// Color attachment. Filtered linearly since it gets stretched over the window when rendering 
+	// below full resolution, and clamped so the edges don't wrap around.
+	glGenTextures(1, &colorTex);
+	glBindTexture(GL_TEXTURE_2D, colorTex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Depth attachment. Never sampled, so a renderbuffer is enough.
+	glGenRenderbuffers(1, &RBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, RBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, RBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "FRAMEBUFFER_INCOMPLETE" << std::endl;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FBO::Bind() {
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+}
+
+// Goes back to rendering into the window.
+void FBO::Unbind() {
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FBO::Delete() {
+	glDeleteTextures(1, &colorTex);
+	glDeleteRenderbuffers(1, &RBO);
+	glDeleteFramebuffers(1, &ID);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// FBO (Frame Buffer Object) is an offscreen render target with a color texture and a depth buffer.
+class FBO {
+public:
+	// Reference ID of the FBO.
+	GLuint ID;
+	// Reference ID of the texture the colors are rendered into.
+	GLuint colorTex;
+	// Reference ID of the renderbuffer storing depth and stencil.
+	GLuint RBO;
+	// Size the attachments were allocated with (the most that can be rendered at once)
+	GLsizei width, height;
+
+	// Constructor that generates a FBO with attachments of the given size.
+	FBO(GLsizei width, GLsizei height);
+
+	void Bind();
+	void Unbind();
+	void Delete();
+};
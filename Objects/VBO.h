@@ -9,6 +9,8 @@ struct Vertex {
 	glm::vec3 normal;
 	glm::vec3 color;
 	glm::vec2 texUV;
+	// Index into the MaterialTable (stored as a float so it links like the other attributes)
+	float material;
 };
 
 // VBO (Vertex Buffer Object) is an array of references.
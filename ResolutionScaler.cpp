@@ -0,0 +1,87 @@
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Constructor that generates the timer queries.
+ResolutionScaler::ResolutionScaler(float targetMs) : targetMs(targetMs) {
+	glGenQueries(NUM_TIMER_QUERIES, queries);
+}
+
+void ResolutionScaler::BeginFrame() {
+	glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+}
+
+void ResolutionScaler::EndFrame(float cpuFrameMs) {
+	glEndQuery(GL_TIME_ELAPSED);
+	++numStarted;
+	current = (current + 1) % NUM_TIMER_QUERIES;
+
+	// The next query to be reused is the oldest one. Its result is read if the GPU has finished
+	// it, otherwise this frame has no new GPU time.
+	bool newGpuTime = false;
+	if (numStarted >= NUM_TIMER_QUERIES) {
+		GLint available = 0;
+		glGetQueryObjectiv(queries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint64 elapsedNs = 0;
+			glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &elapsedNs);
+			gpuMs = elapsedNs / 1000000.0f;
+			newGpuTime = true;
+		}
+	}
+	cpuMs = cpuFrameMs;
+	smoothedCpuMs = smoothedCpuMs == 0.0f ? cpuMs : 0.9f * smoothedCpuMs + 0.1f * cpuMs;
+
+	// Only fresh GPU times count, repeating the last one would count a single slow frame again
+	if (!newGpuTime) {
+		return;
+	}
+	smoothedGpuMs = smoothedGpuMs == 0.0f ? gpuMs : 0.9f * smoothedGpuMs + 0.1f * gpuMs;
+
+	// Waits for frames rendered at the new scale to show up in the measurements after a change
+	if (settleFrames > 0) {
+		--settleFrames;
+		smoothedGpuMs = 0.0f;
+		return;
+	}
+
+	// A frame only counts as over or under the budget if both its own time and the smoothed time
+	// are. A single spike lifts the smoothed time for a while, but the frames after it aren't
+	// over the budget themselves, so they don't add up to a drop.
+	bool over = gpuMs > targetMs && smoothedGpuMs > targetMs;
+	bool under = gpuMs < targetMs * raiseThreshold && smoothedGpuMs < targetMs * raiseThreshold;
+	if (over) {
+		framesUnder = 0;
+		if (++framesOver >= dropFrames) {
+			// Drops further the more the budget is missed by (pixel count scales with scale^2)
+			float wanted = scale * std::sqrt(targetMs / smoothedGpuMs);
+			scale = std::max(minScale, std::min(scale - step, wanted));
+			framesOver = 0;
+			settleFrames = NUM_TIMER_QUERIES;
+		}
+	}
+	// Frames are over the budget no matter the resolution while the CPU is, so the scale isn't
+	// raised until the CPU catches up
+	else if (under && smoothedCpuMs <= targetMs) {
+		framesOver = 0;
+		if (++framesUnder >= raiseFrames) {
+			scale = std::min(maxScale, scale + step);
+			framesUnder = 0;
+			settleFrames = NUM_TIMER_QUERIES;
+		}
+	}
+	else {
+		// Within the band around the target or CPU bound, keeps the current scale
+		framesOver = 0;
+		framesUnder = 0;
+	}
+}
+
+glm::ivec2 ResolutionScaler::RenderSize(int windowWidth, int windowHeight) {
+	return glm::ivec2(std::max(1, (int)(windowWidth * scale)), std::max(1, (int)(windowHeight * scale)));
+}
+
+void ResolutionScaler::Delete() {
+	glDeleteQueries(NUM_TIMER_QUERIES, queries);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Number of GPU timer queries in flight. Results are read a few frames late so reading them
+// never stalls waiting on the GPU.
+#define NUM_TIMER_QUERIES 4
+
+// Picks the resolution the scene is rendered at each frame, lowering it when frames take longer
+// than the budget and raising it again when there is time to spare.
+class ResolutionScaler {
+public:
+	// Frame time (in milliseconds) the scaler tries to stay under
+	float targetMs;
+	// Fraction of the window's width and height the scene is rendered at
+	float scale = 1.0f;
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	// How much the scale changes each time it's adjusted
+	float step = 0.05f;
+	// Hysteresis. The scale drops after dropFrames GPU times in a row over the budget and only 
+	// rises after raiseFrames GPU times in a row under raiseThreshold of the budget, so it doesn't
+	// bounce back and forth around the target.
+	float raiseThreshold = 0.80f;
+	unsigned int dropFrames = 3;
+	unsigned int raiseFrames = 60;
+
+	// Latest measured times (GPU time lags a few frames behind)
+	float gpuMs = 0.0f;
+	float cpuMs = 0.0f;
+	// Smoothed times. The scale is adjusted against the GPU time since that's what the resolution
+	// changes, the CPU time only holds the scale steady while the CPU is the bottleneck.
+	float smoothedGpuMs = 0.0f;
+	float smoothedCpuMs = 0.0f;
+
+	// Constructor that generates the timer queries.
+	ResolutionScaler(float targetMs);
+
+	// Starts timing the GPU work of this frame
+	void BeginFrame();
+	// Stops timing the GPU work of this frame and adjusts the scale for the next one
+	void EndFrame(float cpuFrameMs);
+	// Size to render the scene at for a window of the given size
+	glm::ivec2 RenderSize(int windowWidth, int windowHeight);
+
+	void Delete();
+
+private:
+	GLuint queries[NUM_TIMER_QUERIES];
+	// Query used this frame and how many have been started so far
+	unsigned int current = 0;
+	unsigned int numStarted = 0;
+	unsigned int framesOver = 0;
+	unsigned int framesUnder = 0;
+	// GPU times left to ignore after the scale changed
+	unsigned int settleFrames = 0;
+};
@@ -11,11 +11,26 @@ in vec3 normal;
 in vec3 color;
 // Imports the texture coordinates from the vertex shader
 in vec2 texCoord;
+// Imports the material ID from the vertex shader
+flat in int materialID;
 
-// Gets the texture unit from the main function
-uniform sampler2D diffuse0;
-// Gets the texture unit for the previous texture's specular map from the main function
-uniform sampler2D specular0;
+// Has to match MAX_MATERIALS in MaterialTable.h
+#define MAX_MATERIALS 256
+
+struct Material {
+	// x = diffuse layer, y = specular layer
+	ivec4 layers;
+	// x = specular strength, y = shininess
+	vec4 params;
+};
+
+// Gets the material table from the main function
+layout (std140) uniform Materials {
+	Material materials[MAX_MATERIALS];
+};
+
+// Gets the texture unit of the texture array holding every material's textures
+uniform sampler2DArray materialTextures;
 
 // Gets the color of the light from the main function
 uniform vec4 lightColor;
@@ -24,6 +39,16 @@ uniform vec3 lightPos;
 // Gets the position of the camera from the main function
 uniform vec3 camPos;
 
+// Samples the diffuse layer of the current material
+vec4 DiffuseColor() {
+	return texture(materialTextures, vec3(texCoord, materials[materialID].layers.x));
+}
+
+// Samples the specular layer of the current material
+float SpecularValue() {
+	return texture(materialTextures, vec3(texCoord, materials[materialID].layers.y)).r;
+}
+
 vec4 PointLight() {
 	vec3 lightVec = lightPos - currPos;
 
@@ -48,18 +73,18 @@ vec4 PointLight() {
 
 	// SPECULAR LIGHTING
 	// The max intesity of a specular light
-	float specularLight = 0.50f;
+	float specularLight = materials[materialID].params.x;
 	// Stores the normalized direction the camera is facing
 	vec3 viewDirection = normalize(camPos - currPos);
 	// Stores the direction of the light reflection
 	vec3 reflectionDirection = reflect(-lightDirection, norm);
 	// Stores how much specular light there is at a certain angle
-	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), materials[materialID].params.y);
 	// Stores the specular value
 	float specular = specAmount * specularLight;
 
 	// Outputs textured and lit color
-	return (texture(diffuse0, texCoord) * (diffuse + ambient) + texture(specular0, texCoord).r * specular * intensity) * lightColor;
+	return (DiffuseColor() * (diffuse + ambient) + SpecularValue() * specular * intensity) * lightColor;
 }
 
 vec4 DirecLight() {
@@ -73,14 +98,14 @@ vec4 DirecLight() {
 	float diffuse = max(dot(norm, lightDirection), 0.0f);
 
 	// SPECULAR LIGHTING
-	float specularLight = 0.50f;
+	float specularLight = materials[materialID].params.x;
 	vec3 viewDirection = normalize(camPos - currPos);
 	vec3 reflectionDirection = reflect(-lightDirection, norm);
-	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), materials[materialID].params.y);
 	float specular = specAmount * specularLight;
 
 	// Outputs textured and lit color
-	return (texture(diffuse0, texCoord) * (diffuse + ambient) + texture(specular0, texCoord).r * specular) * lightColor;
+	return (DiffuseColor() * (diffuse + ambient) + SpecularValue() * specular) * lightColor;
 }
 
 vec4 SpotLight() {
@@ -97,10 +122,10 @@ vec4 SpotLight() {
 	float diffuse = max(dot(norm, lightDirection), 0.0f);
 
 	// SPECULAR LIGHTING
-	float specularLight = 0.50f;
+	float specularLight = materials[materialID].params.x;
 	vec3 viewDirection = normalize(camPos - currPos);
 	vec3 reflectionDirection = reflect(-lightDirection, norm);
-	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+	float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), materials[materialID].params.y);
 	float specular = specAmount * specularLight;
 
 	// Calculates the intensity of the currPos based on its angle to the center of the light cone
@@ -108,7 +133,7 @@ vec4 SpotLight() {
 	float intensity = clamp((angle - outerCone) / (innerCone - outerCone), 0.0f, 1.0f);
 
 	// Outputs textured and lit color
-	return (texture(diffuse0, texCoord) * (diffuse * intensity + ambient) + texture(specular0, texCoord).r * specular * intensity) * lightColor;
+	return (DiffuseColor() * (diffuse * intensity + ambient) + SpecularValue() * specular * intensity) * lightColor;
 }
 
 void main() {
@@ -8,6 +8,8 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
 // Texture Coordinates
 layout (location = 3) in vec2 aTex;
+// Material IDs
+layout (location = 4) in float aMaterial;
 
 // Outputs the current position for the fragment shader
 out vec3 currPos;
@@ -17,6 +19,8 @@ out vec3 normal;
 out vec3 color;
 // Outputs the texture coordinates for the fragment shader
 out vec2 texCoord;
+// Outputs the material ID for the fragment shader (flat so it isn't interpolated)
+flat out int materialID;
 
 // Imports the scale of the vertices from the main function
 uniform float scale;
@@ -36,6 +40,8 @@ void main() {
 	color = aColor;
 	// Assigns the texture coordinates from the vertex data to "texCoord"
 	texCoord = aTex;
+	// Assigns the material ID from the vertex data to "materialID"
+	materialID = int(aMaterial);
 
 	// Outputs the positions/coordinates of all vertices
 	gl_Position = camMatrix * vec4(aPos, 1.0);
@@ -0,0 +1,34 @@
+#version 330 core
+
+// Outputs colors in RGBA
+out vec4 FragColor;
+
+// Imports the texture coordinates from the vertex shader
+in vec2 texCoord;
+
+// Gets the texture the scene was rendered into from the main function
+uniform sampler2D scene;
+// Gets the part of the scene texture that was rendered into this frame (render size / texture size)
+uniform vec2 renderScale;
+// Gets how strongly the upscaled image is sharpened (0 is plain bilinear)
+uniform float sharpness;
+
+void main() {
+	vec2 texelSize = 1.0f / vec2(textureSize(scene, 0));
+	// Keeps samples half a texel inside the rendered area so nothing outside it bleeds in
+	vec2 maxUV = renderScale - 0.5f * texelSize;
+	vec2 uv = min(texCoord * renderScale, maxUV);
+
+	// Bilinear sample of the scene
+	vec3 center = texture(scene, uv).rgb;
+
+	// Sharpens by subtracting a blurred copy made from the 4 neighboring texels (unsharp mask), 
+	// which gets back some of the detail lost to bilinear filtering
+	vec3 neighbors = texture(scene, min(uv + vec2(texelSize.x, 0.0f), maxUV)).rgb
+				   + texture(scene, max(uv - vec2(texelSize.x, 0.0f), vec2(0.0f))).rgb
+				   + texture(scene, min(uv + vec2(0.0f, texelSize.y), maxUV)).rgb
+				   + texture(scene, max(uv - vec2(0.0f, texelSize.y), vec2(0.0f))).rgb;
+	vec3 sharpened = center + sharpness * (4.0f * center - neighbors) * 0.25f;
+
+	FragColor = vec4(clamp(sharpened, 0.0f, 1.0f), 1.0f);
+}
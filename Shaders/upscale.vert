@@ -0,0 +1,12 @@
+#version 330 core
+
+// Outputs the texture coordinates for the fragment shader
+out vec2 texCoord;
+
+void main() {
+	// Generates one triangle covering the whole screen from the vertex index, so no vertex buffer 
+	// is needed. Vertices end up at (-1,-1), (3,-1) and (-1,3).
+	vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	texCoord = pos;
+	gl_Position = vec4(pos * 2.0f - 1.0f, 0.0f, 1.0f);
+}
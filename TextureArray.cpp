@@ -0,0 +1,111 @@
+#include "TextureArray.h"
+
+TextureArray::TextureArray(GLsizei width, GLsizei height, GLsizei numLayers, GLuint slot)
+	: width(width), height(height), numLayers(numLayers) {
+	// Generates openGL texture object.
+	glGenTextures(1, &ID);
+	// Insert texture into texture unit slot
+	glActiveTexture(GL_TEXTURE0 + slot);
+	unit = slot;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+
+	// Same settings as a regular Texture so materials look the same in either backend
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	// Allocates storage for all the layers up front without filling them in.
+	// glTexImage3D(type of texture, level, color channels of texture, width, height, layers, 
+	//				LEGACY(just put 0), color channels of image, data type of pixels, image data)
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, numLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	// Unbinds the texture
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+GLint TextureArray::AddLayer(const char* image, GLenum format, GLenum pixelType) {
+	// Flips the image right-side-up, reads the image from a file, and stores it in bytes.
+	int widthImg, heightImg, numColorCh;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* bytes = stbi_load(image, &widthImg, &heightImg, &numColorCh, 0);
+
+	if (bytes == NULL) {
+		std::cout << "TEXTURE_LOADING_ERROR for: " << image << std::endl;
+		return -1;
+	}
+	GLint layer = AddLayer(bytes, widthImg, heightImg, format, pixelType);
+
+	// Deletes the image data as it is already in the openGL texture object.
+	stbi_image_free(bytes);
+
+	return layer;
+}
+
+GLint TextureArray::AddLayer(unsigned char* bytes, int widthImg, int heightImg, GLenum format, GLenum pixelType) {
+	// Every layer shares one size, so images that don't match can't be packed into the array
+	if (widthImg != width || heightImg != height) {
+		std::cout << "TEXTURE_ARRAY_SIZE_MISMATCH" << std::endl;
+		return -1;
+	}
+	if (NumFreeLayers() == 0) {
+		std::cout << "TEXTURE_ARRAY_FULL" << std::endl;
+		return -1;
+	}
+
+	// Reuses removed layers before touching ones that were never filled in
+	GLint layer;
+	if (!freeLayers.empty()) {
+		layer = freeLayers.back();
+		freeLayers.pop_back();
+	}
+	else {
+		layer = nextLayer++;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+	// Rows of single channel images aren't always 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	// Copies the image into its layer (a 1 deep box starting at that layer)
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, format, pixelType, bytes);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	return layer;
+}
+
+void TextureArray::RemoveLayer(GLint layer) {
+	// The old image stays in the layer until something else is copied over it
+	freeLayers.push_back(layer);
+}
+
+GLsizei TextureArray::NumFreeLayers() {
+	return numLayers - nextLayer + (GLsizei)freeLayers.size();
+}
+
+void TextureArray::GenerateMipmaps() {
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::TexUnit(Shader& shader, const char* uniform, GLuint unit) {
+	GLuint texUni = glGetUniformLocation(shader.ID, uniform);
+	shader.Activate();
+	glUniform1i(texUni, unit);
+}
+
+void TextureArray::Bind() {
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+}
+
+void TextureArray::Unbind() {
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::Delete() {
+	glDeleteTextures(1, &ID);
+}
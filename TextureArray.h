@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <stb/stb_image.h>
+#include <vector>
+#include "ShaderClass.h"
+
+// A GL_TEXTURE_2D_ARRAY whose layers all share one size and internal format. Every material's 
+// textures live in a layer of the same array, so switching materials doesn't need a texture bind.
+class TextureArray {
+public:
+	GLuint ID;
+	GLuint unit;
+	// Size every layer has to be
+	GLsizei width, height;
+	// Number of layers allocated and the next one that has never been used
+	GLsizei numLayers;
+	GLsizei nextLayer = 0;
+	// Layers that were removed and can be filled in again
+	std::vector<GLint> freeLayers;
+
+	TextureArray(GLsizei width, GLsizei height, GLsizei numLayers, GLuint slot);
+
+	// Loads an image into the next empty layer and returns that layer (-1 if it couldn't be added)
+	GLint AddLayer(const char* image, GLenum format, GLenum pixelType);
+	// Copies already decoded image data into an empty layer and returns that layer
+	GLint AddLayer(unsigned char* bytes, int widthImg, int heightImg, GLenum format, GLenum pixelType);
+	// Marks a layer as empty so a later AddLayer can reuse it
+	void RemoveLayer(GLint layer);
+	// Number of layers that can still be added
+	GLsizei NumFreeLayers();
+	// Generates the mipmaps of every layer (call once after adding layers)
+	void GenerateMipmaps();
+
+	void TexUnit(Shader& shader, const char* uniform, GLuint unit);
+	void Bind();
+	void Unbind();
+	void Delete();
+};
@@ -0,0 +1,424 @@
+#include "WorldStreamer.h"
+
+#include <algorithm>
+
+WorldStreamer::WorldStreamer(TextureArray& textureArray, MaterialTable& materialTable, CellLoader loader,
+							 float cellSize, float loadRadius, size_t memoryCap, unsigned int numThreads)
+	: cellSize(cellSize), loadRadius(loadRadius), evictMargin(cellSize), memoryCap(memoryCap),
+	  textureArray(textureArray), materialTable(materialTable), loader(loader) {
+	// Loader threads decode images the same way Texture does
+	stbi_set_flip_vertically_on_load(true);
+
+	for (unsigned int i = 0; i < numThreads; ++i) {
+		threads.push_back(std::thread(&WorldStreamer::LoaderThread, this));
+	}
+}
+
+WorldStreamer::~WorldStreamer() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	// Images of cells that never became resident
+	for (LoadedCell& cell : loadedCells) {
+		FreeImages(cell.data);
+	}
+	for (LoadedCell& cell : readyCells) {
+		FreeImages(cell.data);
+	}
+}
+
+long long WorldStreamer::Key(glm::ivec2 coords) {
+	return (long long)(((unsigned long long)(unsigned int)coords.x << 32) | (unsigned int)coords.y);
+}
+
+int WorldStreamer::NumChannels(GLenum format) {
+	switch (format) {
+	case GL_RED: return 1;
+	case GL_RG: return 2;
+	case GL_RGB: return 3;
+	case GL_RGBA: return 4;
+	default: return 0;
+	}
+}
+
+glm::vec2 WorldStreamer::Center(glm::ivec2 coords) {
+	return (glm::vec2(coords) + 0.5f) * cellSize;
+}
+
+bool WorldStreamer::InRange(glm::vec2 center, glm::vec2 pos, glm::vec2 predicted, float radius) {
+	return glm::distance(center, pos) <= radius || glm::distance(center, predicted) <= radius;
+}
+
+void WorldStreamer::Update(glm::vec3 camPos) {
+	Clock::time_point frameStart = Clock::now();
+
+	// Estimates the camera's velocity on the XZ plane to predict where it's heading
+	glm::vec2 pos = glm::vec2(camPos.x, camPos.z);
+	if (!firstUpdate) {
+		float dt = std::chrono::duration<float>(frameStart - lastUpdate).count();
+		if (dt > 0.0f) {
+			velocity = (pos - lastPos) / dt;
+		}
+	}
+	else {
+		firstUpdateTime = frameStart;
+	}
+	firstUpdate = false;
+	lastUpdate = frameStart;
+	lastPos = pos;
+	glm::vec2 predicted = pos + velocity * lookahead;
+
+	// Gives rejected cells another chance once the camera is somewhere else
+	glm::ivec2 camCell = glm::ivec2(glm::floor(pos / cellSize));
+	if (camCell != lastCamCell) {
+		rejectedCells.clear();
+		lastCamCell = camCell;
+	}
+
+	// EVICTION
+	// Cells that are out of range of both where the camera is and where it's heading
+	std::vector<long long> outOfRange;
+	for (auto& [key, cell] : residentCells) {
+		if (!InRange(cell.center, pos, predicted, loadRadius + evictMargin)) {
+			outOfRange.push_back(key);
+		}
+	}
+	for (long long key : outOfRange) {
+		Evict(key);
+	}
+
+	// PREFETCHING
+	// Gathers the missing cells around the camera and around where it's heading
+	std::vector<std::pair<float, glm::ivec2>> wanted;
+	std::unordered_set<long long> seen;
+	glm::vec2 around[] = { pos, predicted };
+	for (glm::vec2 point : around) {
+		glm::ivec2 first = glm::ivec2(glm::floor((point - loadRadius) / cellSize));
+		glm::ivec2 last = glm::ivec2(glm::floor((point + loadRadius) / cellSize));
+		for (int x = first.x; x <= last.x; ++x) {
+			for (int z = first.y; z <= last.y; ++z) {
+				glm::ivec2 coords = glm::ivec2(x, z);
+				long long key = Key(coords);
+				glm::vec2 center = Center(coords);
+				if (glm::distance(center, point) > loadRadius || !seen.insert(key).second ||
+					residentCells.count(key) || rejectedCells.count(key)) {
+					continue;
+				}
+				// Cells closest to where the camera is heading are loaded first
+				wanted.push_back(std::make_pair(glm::distance(center, predicted), coords));
+			}
+		}
+	}
+	// Sorted furthest first so loader threads can pop the most important cell off the back
+	std::sort(wanted.begin(), wanted.end(),
+			  [](const std::pair<float, glm::ivec2>& a, const std::pair<float, glm::ivec2>& b) { return a.first > b.first; });
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Rebuilt every frame, so cells that went out of range before being picked up are dropped
+		// and the rest follow the camera's current position and velocity
+		pendingCells.clear();
+		loaderBudget = memoryCap > residentBytes ? memoryCap - residentBytes : 0;
+		for (std::pair<float, glm::ivec2>& cell : wanted) {
+			if (!loadingCells.count(Key(cell.second))) {
+				pendingCells.push_back(cell.second);
+			}
+		}
+		for (LoadedCell& cell : loadedCells) {
+			readyCells.push_back(std::move(cell));
+		}
+		loadedCells.clear();
+	}
+	wake.notify_all();
+
+	// RESIDENCY
+	// Closest cells first, as many as fit in this frame's budget
+	std::sort(readyCells.begin(), readyCells.end(), [this, pos](const LoadedCell& a, const LoadedCell& b) {
+		return glm::distance(Center(a.coords), pos) < glm::distance(Center(b.coords), pos);
+	});
+	std::vector<long long> finished;
+	size_t numProcessed = 0;
+	for (; numProcessed < readyCells.size(); ++numProcessed) {
+		LoadedCell& cell = readyCells[numProcessed];
+		float elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+		// Always makes progress on at least one cell, otherwise stops before going over budget
+		if (numProcessed > 0 && elapsedMs + avgResidentMs > frameBudgetMs) {
+			break;
+		}
+
+		finished.push_back(Key(cell.coords));
+		if (!InRange(Center(cell.coords), pos, predicted, loadRadius + evictMargin)) {
+			FreeImages(cell.data);
+			continue;
+		}
+
+		Clock::time_point start = Clock::now();
+		MakeResident(cell, pos);
+		float residentMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		avgResidentMs = avgResidentMs == 0.0f ? residentMs : 0.8f * avgResidentMs + 0.2f * residentMs;
+	}
+	readyCells.erase(readyCells.begin(), readyCells.begin() + numProcessed);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (long long key : finished) {
+			loadingCells.erase(key);
+		}
+		loaderBudget = memoryCap > residentBytes ? memoryCap - residentBytes : 0;
+	}
+	// Uploading and dropping cells freed decoded images, which may let loader threads continue
+	wake.notify_all();
+
+	if (materialsChanged) {
+		materialTable.Upload();
+		materialsChanged = false;
+	}
+
+	Clock::time_point frameEnd = Clock::now();
+	lastUpdateMs = std::chrono::duration<float, std::milli>(frameEnd - frameStart).count();
+	maxUpdateMs = std::max(maxUpdateMs, lastUpdateMs);
+	if (lastUpdateMs > hitchThresholdMs) {
+		++numHitches;
+	}
+	// Nothing in range was missing at the start of this update and nothing is left to upload
+	if (startupMs == 0.0f && wanted.empty() && readyCells.empty()) {
+		startupMs = std::chrono::duration<float, std::milli>(frameEnd - firstUpdateTime).count();
+	}
+}
+
+void WorldStreamer::LoaderThread() {
+	while (true) {
+		glm::ivec2 coords;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			// Waits while the decoded images already waiting to be uploaded use up the memory cap,
+			// otherwise every cell in range would decode its images before any of them is uploaded
+			wake.wait(lock, [this] { return stopping || (!pendingCells.empty() && decodedBytes < loaderBudget); });
+			if (stopping) {
+				return;
+			}
+			coords = pendingCells.back();
+			pendingCells.pop_back();
+			loadingCells.insert(Key(coords));
+		}
+
+		LoadedCell cell;
+		cell.coords = coords;
+		loader(coords, cellSize, cell.data);
+		// Splitting the cell into meshlets is too slow for the main thread's budget
+		cell.data.meshlets = BuildMeshlets(cell.data.vertices, cell.data.indices);
+
+		// Decodes the images that aren't already in the texture array
+		for (CellImage& image : cell.data.images) {
+			bool resident;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				resident = residentPaths.count(image.path) > 0;
+			}
+			if (!resident) {
+				// Decodes into as many channels as the format uploads, whatever the file has, so the
+				// upload never reads past the end of the decoded image. stb decodes 8 bits per channel.
+				image.numColorCh = NumChannels(image.format);
+				if (image.numColorCh == 0 || image.pixelType != GL_UNSIGNED_BYTE) {
+					std::cout << "TEXTURE_FORMAT_UNSUPPORTED for: " << image.path << std::endl;
+					image.failed = true;
+					continue;
+				}
+				int numFileCh;
+				image.bytes = stbi_load(image.path.c_str(), &image.width, &image.height, &numFileCh, image.numColorCh);
+				// Every layer shares one size, so images that don't match are treated like ones that
+				// failed to load (the texture array's size never changes, so reading it here is safe)
+				if (image.bytes == NULL) {
+					std::cout << "TEXTURE_LOADING_ERROR for: " << image.path << std::endl;
+					image.failed = true;
+				}
+				else if (image.width != textureArray.width || image.height != textureArray.height) {
+					std::cout << "TEXTURE_ARRAY_SIZE_MISMATCH for: " << image.path << std::endl;
+					stbi_image_free(image.bytes);
+					image.bytes = NULL;
+					image.failed = true;
+				}
+				else {
+					std::lock_guard<std::mutex> lock(mutex);
+					decodedBytes += (size_t)image.width * image.height * image.numColorCh;
+				}
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			loadedCells.push_back(std::move(cell));
+		}
+	}
+}
+
+bool WorldStreamer::MakeResident(LoadedCell& cell, glm::vec2 pos) {
+	CellData& data = cell.data;
+	glm::vec2 center = Center(cell.coords);
+	float dist = glm::distance(center, pos);
+	size_t layerBytes = (size_t)textureArray.width * textureArray.height * 4;
+	// The GPU buffers plus the copy Mesh keeps on the CPU, and the meshlets it culls
+	size_t geometryBytes = 2 * (data.vertices.size() * sizeof(Vertex) + data.indices.size() * sizeof(GLuint)) +
+						   data.meshlets.size() * sizeof(Meshlet);
+
+	while (true) {
+		// Counts the layers this cell would add. Evicting a cell can free an image this cell
+		// needs, so this is redone after every eviction.
+		size_t bytes = geometryBytes;
+		GLsizei numNewLayers = 0;
+		for (CellImage& image : data.images) {
+			if (residentImages.count(image.path) || image.failed) {
+				continue;
+			}
+			// Was resident when the loader thread looked but has been evicted since. That's a race
+			// rather than a lack of room, so the cell isn't rejected. It's no longer loading once 
+			// Update() is done with it, so the next Update() queues it up again and the image gets
+			// decoded this time.
+			if (image.bytes == NULL) {
+				FreeImages(data);
+				return false;
+			}
+			bytes += layerBytes;
+			++numNewLayers;
+		}
+		// Every material of the cell takes its own slot in the material table, and handing out an
+		// ID that's already in use would overwrite another cell's material
+		if (residentBytes + bytes <= memoryCap && numNewLayers <= textureArray.NumFreeLayers() &&
+			data.materials.size() <= materialTable.NumFreeMaterials()) {
+			break;
+		}
+
+		// Makes room by evicting the furthest cell, but only if it's further than this one
+		long long furthest = 0;
+		float furthestDist = dist;
+		for (auto& [key, resident] : residentCells) {
+			float residentDist = glm::distance(resident.center, pos);
+			if (residentDist > furthestDist) {
+				furthest = key;
+				furthestDist = residentDist;
+			}
+		}
+		if (furthestDist == dist) {
+			rejectedCells.insert(Key(cell.coords));
+			FreeImages(data);
+			return false;
+		}
+		Evict(furthest);
+	}
+
+	// Copies the images into the texture array (or shares the layer if it's already there)
+	std::vector<GLint> layers;
+	// Paths this cell holds a reference to, released again when it's evicted
+	std::vector<std::string> images;
+	for (CellImage& image : data.images) {
+		auto it = residentImages.find(image.path);
+		if (it != residentImages.end()) {
+			it->second.refs++;
+			layers.push_back(it->second.layer);
+			images.push_back(image.path);
+			continue;
+		}
+		// Images that failed to load or don't fit the array fall back to the first layer, the 
+		// cell's geometry is still drawn
+		GLint layer = image.failed ? -1 : textureArray.AddLayer(image.bytes, image.width, image.height, image.format, image.pixelType);
+		if (layer < 0) {
+			layers.push_back(0);
+			continue;
+		}
+		residentImages[image.path] = ResidentImage{ layer, 1 };
+		layers.push_back(layer);
+		images.push_back(image.path);
+		// Layers are counted on their own since cells share them
+		residentBytes += layerBytes;
+		std::lock_guard<std::mutex> lock(mutex);
+		residentPaths.insert(image.path);
+	}
+	FreeImages(data);
+
+	// Swaps the cell's own material indices for material table IDs
+	std::vector<GLuint> materials;
+	for (CellMaterial& material : data.materials) {
+		materials.push_back(materialTable.AddMaterial(layers[material.diffuseImage], layers[material.specularImage],
+													  material.specularStrength, material.shininess));
+	}
+	for (Vertex& vertex : data.vertices) {
+		vertex.material = (float)materials[(int)vertex.material];
+	}
+	materialsChanged = true;
+
+	std::vector<Texture> textures;
+	residentCells.emplace(Key(cell.coords), ResidentCell{ Mesh(data.vertices, data.indices, data.meshlets, textures),
+														  center, images, materials, geometryBytes });
+	residentBytes += geometryBytes;
+	return true;
+}
+
+void WorldStreamer::Evict(long long key) {
+	auto it = residentCells.find(key);
+	if (it == residentCells.end()) {
+		return;
+	}
+	ResidentCell& cell = it->second;
+
+	cell.mesh.Delete();
+	for (GLuint material : cell.materials) {
+		materialTable.RemoveMaterial(material);
+	}
+	materialsChanged = true;
+
+	// Layers are only freed once no resident cell uses them anymore
+	size_t layerBytes = (size_t)textureArray.width * textureArray.height * 4;
+	for (std::string& path : cell.images) {
+		auto image = residentImages.find(path);
+		if (image == residentImages.end() || --image->second.refs > 0) {
+			continue;
+		}
+		textureArray.RemoveLayer(image->second.layer);
+		residentImages.erase(image);
+		residentBytes -= layerBytes;
+		std::lock_guard<std::mutex> lock(mutex);
+		residentPaths.erase(path);
+	}
+
+	residentBytes -= cell.bytes;
+	residentCells.erase(it);
+}
+
+void WorldStreamer::FreeImages(CellData& data) {
+	size_t freedBytes = 0;
+	for (CellImage& image : data.images) {
+		if (image.bytes != NULL) {
+			freedBytes += (size_t)image.width * image.height * image.numColorCh;
+		}
+		stbi_image_free(image.bytes);
+		image.bytes = NULL;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	decodedBytes -= freedBytes;
+}
+
+void WorldStreamer::Draw(Shader& shader, Camera& camera) {
+	for (auto& [key, cell] : residentCells) {
+		cell.mesh.Draw(shader, camera);
+	}
+}
+
+size_t WorldStreamer::NumResident() {
+	return residentCells.size();
+}
+
+void WorldStreamer::Delete() {
+	std::vector<long long> keys;
+	for (auto& [key, cell] : residentCells) {
+		keys.push_back(key);
+	}
+	for (long long key : keys) {
+		Evict(key);
+	}
+}
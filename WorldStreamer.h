@@ -0,0 +1,178 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "Mesh.h"
+#include "TextureArray.h"
+#include "MaterialTable.h"
+
+// An image a cell uses. The cell loader only fills in the path and format, the streamer decodes
+// the image on the loader thread unless it's already in the texture array.
+struct CellImage {
+	std::string path;
+	GLenum format;
+	GLenum pixelType;
+	unsigned char* bytes = NULL;
+	// numColorCh is the channels of the decoded bytes, which always matches format
+	int width = 0, height = 0, numColorCh = 0;
+	// Set by the loader thread if the image couldn't be decoded or doesn't fit the texture array
+	bool failed = false;
+};
+
+// A material a cell uses. The images are indices into CellData::images.
+struct CellMaterial {
+	int diffuseImage;
+	int specularImage;
+	float specularStrength;
+	float shininess;
+};
+
+// Everything a cell is made of. Until the cell becomes resident, Vertex::material is an index
+// into materials rather than a MaterialTable ID.
+struct CellData {
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	std::vector<CellImage> images;
+	std::vector<CellMaterial> materials;
+	// Built by the streamer on the loader thread, which also reorders the indices
+	std::vector<Meshlet> meshlets;
+};
+
+// Fills in the cell at the given grid coordinates. Runs on the loader threads, so it must not
+// make any openGL calls.
+typedef std::function<void(glm::ivec2 cell, float cellSize, CellData& data)> CellLoader;
+
+// Splits the world into a grid of square cells on the XZ plane and keeps only the cells around
+// the camera resident. Cells are built and their images decoded on background threads, while
+// the openGL side (buffers, texture layers, materials) is done on the main thread within a time
+// budget each frame.
+class WorldStreamer {
+public:
+	// Size of a cell along X and Z
+	float cellSize;
+	// Cells whose center is within this distance of the camera, or of where it's heading, are
+	// loaded
+	float loadRadius;
+	// Cells are only evicted once they are this much further than loadRadius, so moving back and
+	// forth over a cell border doesn't reload them
+	float evictMargin;
+	// Maximum bytes of resident geometry and texture layers plus decoded images waiting to be
+	// uploaded. Loader threads stop taking cells while it's used up, so it can only be overshot by
+	// the images of the cells they are working on at that moment.
+	size_t memoryCap;
+	// Seconds ahead the camera's velocity is used to predict where it's heading
+	float lookahead = 1.0f;
+	// Milliseconds per frame that can be spent making cells resident
+	float frameBudgetMs = 2.0f;
+	// Update() calls that take longer than this are counted as hitches
+	float hitchThresholdMs = 4.0f;
+
+	// Stats of the streamer. The times only cover Update(), not drawing the cells.
+	size_t residentBytes = 0;
+	unsigned int numHitches = 0;
+	float lastUpdateMs = 0.0f;
+	float maxUpdateMs = 0.0f;
+	// Milliseconds from the first Update() until every cell in range was resident, 0 until then
+	float startupMs = 0.0f;
+
+	// Starts numThreads loader threads. Nothing is loaded until the first Update().
+	WorldStreamer(TextureArray& textureArray, MaterialTable& materialTable, CellLoader loader,
+				  float cellSize, float loadRadius, size_t memoryCap, unsigned int numThreads);
+	// Stops and joins the loader threads
+	~WorldStreamer();
+
+	// Requests, evicts and makes resident the cells around the camera. Call once per frame
+	// before drawing.
+	void Update(glm::vec3 camPos);
+	// Draws every resident cell
+	void Draw(Shader& shader, Camera& camera);
+	// Number of cells that are currently resident
+	size_t NumResident();
+	// Deletes every resident cell
+	void Delete();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	// A cell a loader thread finished building
+	struct LoadedCell {
+		glm::ivec2 coords;
+		CellData data;
+	};
+	// A cell that is drawn, with everything it holds on to in the texture array and material table
+	struct ResidentCell {
+		Mesh mesh;
+		glm::vec2 center;
+		std::vector<std::string> images;
+		std::vector<GLuint> materials;
+		// Bytes of geometry (shared texture layers are counted separately)
+		size_t bytes;
+	};
+	// A texture array layer shared by all resident cells using the same image
+	struct ResidentImage {
+		GLint layer;
+		unsigned int refs;
+	};
+
+	TextureArray& textureArray;
+	MaterialTable& materialTable;
+	CellLoader loader;
+
+	// Main thread state
+	std::unordered_map<long long, ResidentCell> residentCells;
+	std::unordered_map<std::string, ResidentImage> residentImages;
+	// Cells that were loaded but didn't fit under the memory cap. Cleared when the camera moves
+	// to another cell so they aren't reloaded over and over.
+	std::unordered_set<long long> rejectedCells;
+	// Loaded cells waiting for their turn in the frame budget
+	std::vector<LoadedCell> readyCells;
+	glm::vec2 lastPos = glm::vec2(0.0f);
+	glm::vec2 velocity = glm::vec2(0.0f);
+	glm::ivec2 lastCamCell = glm::ivec2(0);
+	bool firstUpdate = true;
+	Clock::time_point firstUpdateTime;
+	Clock::time_point lastUpdate;
+	// Running average of how long making a cell resident takes
+	float avgResidentMs = 0.0f;
+	bool materialsChanged = false;
+
+	// State shared with the loader threads (guarded by mutex)
+	std::mutex mutex;
+	std::condition_variable wake;
+	// Cells waiting for a loader thread, the most important one at the back
+	std::vector<glm::ivec2> pendingCells;
+	// Cells taken by a loader thread that haven't been made resident or dropped yet
+	std::unordered_set<long long> loadingCells;
+	std::vector<LoadedCell> loadedCells;
+	// Paths of images in the texture array, so loader threads don't decode them again
+	std::unordered_set<std::string> residentPaths;
+	// Bytes of decoded images that haven't been uploaded or freed yet
+	size_t decodedBytes = 0;
+	// What's left of memoryCap after the resident cells, updated by Update()
+	size_t loaderBudget = 0;
+	bool stopping = false;
+
+	std::vector<std::thread> threads;
+
+	static long long Key(glm::ivec2 coords);
+	// Channels per pixel of an upload format, 0 for formats the streamer can't decode into
+	static int NumChannels(GLenum format);
+	glm::vec2 Center(glm::ivec2 coords);
+	bool InRange(glm::vec2 center, glm::vec2 pos, glm::vec2 predicted, float radius);
+
+	// Loop run by each loader thread
+	void LoaderThread();
+	// Uploads a loaded cell. Returns false if it couldn't be made resident.
+	bool MakeResident(LoadedCell& cell, glm::vec2 pos);
+	void Evict(long long key);
+	// Frees the decoded images of a cell that won't be made resident
+	void FreeImages(CellData& data);
+};
@@ -39,6 +39,11 @@
 */
 
 #include "Mesh.h"
+#include "TextureArray.h"
+#include "MaterialTable.h"
+#include "WorldStreamer.h"
+#include "ResolutionScaler.h"
+#include "Objects/FBO.h"
 
 // Size of window
 const unsigned int width = 800;
@@ -53,10 +58,11 @@ Vertex vertices[] = {
 	Vertex{glm::vec3(1.0f, 0.0f,  1.0f),	glm::vec3(0.0f, 1.0f, 0.0f),	glm::vec3(1.0f, 1.0f, 1.0f),	glm::vec2(1.0f, 0.0f)}
 };
 
-// Indices for vertex order of plane (all the triangles)
+// Indices for vertex order of plane (all the triangles). Counter-clockwise seen from above, so the 
+// plane faces up and meshlet culling only drops it when seen from below.
 GLuint indices[] = {
-	0, 1, 2,	// Bottom side
-	0, 2, 3,	// Bottom side
+	0, 2, 1,	// Top side
+	0, 3, 2,	// Top side
 };
 
 // Vertices of light cube
@@ -87,6 +93,27 @@ GLuint lightIndices[] = {
 	4, 6, 7
 };
 
+// Builds a floor cell of the world out of the plane above, scaled to fill the cell. Runs on the 
+// world streamer's loader threads.
+void LoadFloorCell(glm::ivec2 cell, float cellSize, CellData& data) {
+	glm::vec3 center = glm::vec3((cell.x + 0.5f) * cellSize, 0.0f, (cell.y + 0.5f) * cellSize);
+	float scale = cellSize / 2.0f;
+	for (Vertex vertex : vertices) {
+		vertex.position = center + vertex.position * scale;
+		// Keeps the planks the same size no matter how big the cells are
+		vertex.texUV *= scale;
+		vertex.material = 0.0f;
+		data.vertices.push_back(vertex);
+	}
+	data.indices.assign(indices, indices + sizeof(indices) / sizeof(GLuint));
+
+	data.images.push_back(CellImage{ "Textures/planks.png", GL_RGBA, GL_UNSIGNED_BYTE });
+	data.images.push_back(CellImage{ "Textures/planksSpec.png", GL_RED, GL_UNSIGNED_BYTE });
+	// Checkerboard of shiny and dull planks
+	bool shiny = ((cell.x + cell.y) & 1) == 0;
+	data.materials.push_back(CellMaterial{ 0, 1, shiny ? 0.50f : 0.15f, shiny ? 8.0f : 4.0f });
+}
+
 int main() {
 	// =============================== USING GLFW TO MAKE A WINDOW ===============================
 	// Initialize glfw library
@@ -118,20 +145,22 @@ int main() {
 	glViewport(0, 0, width, height);
 	// ===========================================================================================
 
-	// Texture data
-	Texture textures[] {
-		Texture("Textures/planks.png", "diffuse", 0, GL_RGBA, GL_UNSIGNED_BYTE),
-		Texture("Textures/planksSpec.png", "specular", 1, GL_RED, GL_UNSIGNED_BYTE)
-	};
+	// Texture data. Every material's textures are packed into the layers of one texture array, 
+	// which the world streamer fills in as cells come into range.
+	TextureArray textureArray(1024, 1024, 16, 0);
+
+	// Material table mapping the material IDs stored in the vertices to layers and parameters
+	MaterialTable materialTable(0);
 
 	// Creates shader program from default vertex and fragment shader files
 	Shader shaderProgram("Shaders/default.vert", "Shaders/default.frag");
+	textureArray.TexUnit(shaderProgram, "materialTextures", textureArray.unit);
+	materialTable.BlockBinding(shaderProgram, "Materials");
 
-	// Constructs floor object mesh
-	std::vector<Vertex> verts(vertices, vertices + sizeof(vertices) / sizeof(Vertex));
-	std::vector<GLuint> ind(indices, indices + sizeof(indices) / sizeof(GLuint));
-	std::vector<Texture> tex(textures, textures + sizeof(textures) / sizeof(Texture));
-	Mesh floor(verts, ind, tex);
+	// Streams the floor in cells of 4x4 around the camera instead of building it all up front. 
+	// Cells within 12 units are kept, using at most 64MB of geometry and texture layers.
+	unsigned int numLoaderThreads = std::thread::hardware_concurrency() > 2 ? 2 : 1;
+	WorldStreamer world(textureArray, materialTable, LoadFloorCell, 4.0f, 12.0f, 64 * 1024 * 1024, numLoaderThreads);
 
 	// Creates light shader program from light vertex and fragment shader files
 	Shader lightShader("Shaders/light.vert", "Shaders/light.frag");
@@ -139,6 +168,7 @@ int main() {
 	// Constructs light object mesh
 	std::vector<Vertex> lightVerts(lightVertices, lightVertices + sizeof(lightVertices) / sizeof(Vertex));
 	std::vector<GLuint> lightInd(lightIndices, lightIndices + sizeof(lightIndices) / sizeof(GLuint));
+	std::vector<Texture> tex;
 	Mesh light(lightVerts, lightInd, tex);
 
 	glm::vec4 lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -162,12 +192,35 @@ int main() {
 	// Enables the depth buffer. Otherwise, openGL doesn't know which faces to render on top.
 	glEnable(GL_DEPTH_TEST);
 
+	// The scene is rendered offscreen, into as much of this framebuffer as the resolution scaler 
+	// allows, and then upscaled to the window
+	FBO sceneFBO(width, height);
+	// Keeps frames under 1/60th of a second
+	ResolutionScaler resolutionScaler(16.6f);
+
+	// Creates upscale shader program from upscale vertex and fragment shader files
+	Shader upscaleShader("Shaders/upscale.vert", "Shaders/upscale.frag");
+	upscaleShader.Activate();
+	glUniform1i(glGetUniformLocation(upscaleShader.ID, "scene"), 0);
+	glUniform1f(glGetUniformLocation(upscaleShader.ID, "sharpness"), 0.5f);
+	// The upscale pass has no vertices, but core profile still needs a VAO bound to draw
+	VAO screenVAO;
+
 	// Initializes a camera that is 2.0 away from the world origin
 	Camera camera(width, height, glm::vec3(0.0f, 0.0f, 2.0f));
 
 	// Keeps the window open until it should close. The closing condition can be the close button 
 	// or another function.
 	while (!glfwWindowShouldClose(window)) {
+		double frameStart = glfwGetTime();
+		resolutionScaler.BeginFrame();
+
+		// Renders the scene offscreen at the resolution picked for this frame
+		glm::ivec2 renderSize = resolutionScaler.RenderSize(width, height);
+		sceneFBO.Bind();
+		glViewport(0, 0, renderSize.x, renderSize.y);
+		glEnable(GL_DEPTH_TEST);
+
 		// Clears the color of the buffer and gives it another color.
 		glClearColor(0.07f, 0.13f, 0.17f, 1.0f); // Navy Blue
 		// Specifies to openGL to use the previous command on the color buffer.
@@ -178,9 +231,31 @@ int main() {
 		// Updates the camera matrix
 		camera.UpdateMatrix(45.0f, 0.1f, 100.0f);
 
+		// Loads the cells around the camera and uploads as many as fit in this frame
+		world.Update(camera.pos);
+
+		// Binds the textures and materials of every mesh at once
+		textureArray.Bind();
+		materialTable.Bind();
+
 		// Renders the floor and light objects in the scene
-		floor.Draw(shaderProgram, camera);
-		light.Draw(lightShader, camera);
+		world.Draw(shaderProgram, camera);
+		light.Draw(lightShader, camera, lightModel);
+
+		// Upscales the rendered part of the scene to the whole window
+		sceneFBO.Unbind();
+		glViewport(0, 0, width, height);
+		glDisable(GL_DEPTH_TEST);
+		upscaleShader.Activate();
+		glUniform2f(glGetUniformLocation(upscaleShader.ID, "renderScale"), 
+					(float)renderSize.x / sceneFBO.width, (float)renderSize.y / sceneFBO.height);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, sceneFBO.colorTex);
+		screenVAO.Bind();
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+
+		// CPU time is taken before swapping since swapping waits for vsync
+		resolutionScaler.EndFrame((float)((glfwGetTime() - frameStart) * 1000.0));
 
 		// The back buffer contains the color we want. This swaps the front and back buffer.
 		glfwSwapBuffers(window);
@@ -189,9 +264,22 @@ int main() {
 		glfwPollEvents();
 	}
 
+	std::cout << "World streaming: all cells in range after " << world.startupMs << "ms, slowest update " 
+			  << world.maxUpdateMs << "ms, " << world.numHitches << " hitches over " << world.hitchThresholdMs 
+			  << "ms, " << world.NumResident() << " cells (" << world.residentBytes / (1024 * 1024) << "MB) resident" 
+			  << std::endl;
+
 	// Memory cleanup
+	world.Delete();
+	light.Delete();
 	shaderProgram.Delete();
 	lightShader.Delete();
+	textureArray.Delete();
+	materialTable.Delete();
+	upscaleShader.Delete();
+	screenVAO.Delete();
+	sceneFBO.Delete();
+	resolutionScaler.Delete();
 
 	// Closing the application
 	glfwDestroyWindow(window);